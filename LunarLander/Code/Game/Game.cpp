@@ -21,6 +21,25 @@
 #include "Game/GameCommon.hpp"
 #include "Game/GameConfig.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr float MaxRunSeconds = 600.0f;
+constexpr auto MaxGhostFrames = static_cast<std::size_t>(MaxRunSeconds / ScoreFormat::GhostTickSeconds);
+constexpr std::size_t LeaderboardSize = 10u;
+constexpr float MaxLandingSpeed = 40.0f;
+constexpr float MaxLandingTiltDegrees = 10.0f;
+constexpr float CeilingHeightAboveSpawn = 1000.0f;
+constexpr float FuelPickupRadius = 24.0f;
+
+} // namespace
 
 void GameOptions::SaveToConfig(Config& config) noexcept {
     GameSettings::SaveToConfig(config);
@@ -73,8 +92,17 @@ void Game::Initialize() noexcept {
 
     m_landerSheet = g_theRenderer->CreateSpriteSheet("Data/Images/Lander.png", 3, 1);
 
+    const auto level_name = std::string{"Level01"};
+    m_level = Level{std::filesystem::path{"Data/Definitions"} / (level_name + ".level")};
+    m_levelId = ScoreStore::CalcLevelId(level_name);
+
+    m_scores = std::make_unique<ScoreStore>(std::filesystem::path{"Data/Scores"});
+
     m_lander = std::make_unique<Lander>();
-    m_lander->SetPosition(Vector2::Zero);
+    if(m_level.IsLoaded()) {
+        m_lander->SetGravity(m_level.GetEnvironment().gravity);
+    }
+    Respawn();
 
 }
 
@@ -90,7 +118,18 @@ void Game::Update(TimeUtils::FPSeconds deltaSeconds) noexcept {
     m_ui_camera2D.Update(deltaSeconds);
     m_cameraController.Update(deltaSeconds);
 
+    m_windSeconds += deltaSeconds.count();
+    m_lander->ApplyWind(m_level.CalcWindSpeed(m_windSeconds), deltaSeconds);
     m_lander->Update(deltaSeconds);
+    if(m_level.IsLoaded()) {
+        RecordGhostFrames(deltaSeconds);
+        UpdateRun();
+    }
+    //The store recovers and writes on its own thread; refresh once it reports new results.
+    if(const auto change_count = m_scores->GetChangeCount(); change_count != m_scoreChangeCount) {
+        m_scoreChangeCount = change_count;
+        RefreshLeaderboard();
+    }
     m_cameraController.SetPosition(Vector2::Zero);
     m_cameraController.SetRotationDegrees(0.0f);
     if(IsCameraRotationLockedToLander()) {
@@ -108,17 +147,22 @@ void Game::Render() const noexcept {
     //World View
     m_cameraController.SetModelViewProjectionBounds();
 
-    g_theRenderer->SetMaterial("__2D");
-    AABB2 ground = AABB2::Neg_One_to_One;
-    ground.ScalePadding(100.0, 50.0f);
-    ground.Translate(Vector2{ 0.0f, 100.0f - ground.CalcDimensions().y * 0.5f });
+    if(m_level.IsLoaded()) {
+        m_level.Render(CalcWorldViewBounds(), m_collectedFuel);
+    } else {
+        g_theRenderer->SetMaterial("__2D");
+        AABB2 ground = AABB2::Neg_One_to_One;
+        ground.ScalePadding(100.0, 50.0f);
+        ground.Translate(Vector2{ 0.0f, 100.0f - ground.CalcDimensions().y * 0.5f });
 
-    g_theRenderer->SetModelMatrix(Matrix4::I);
-    g_theRenderer->DrawAABB2(ground, Rgba::White, Rgba::LightGray, Vector2::One);
+        g_theRenderer->SetModelMatrix(Matrix4::I);
+        g_theRenderer->DrawAABB2(ground, Rgba::White, Rgba::LightGray, Vector2::One);
+    }
 
     m_lander->Render();
     if (m_debug_render) {
         m_lander->DebugRender();
+        DebugRenderBestGhost();
     }
     // HUD View
 
@@ -129,6 +173,7 @@ void Game::Render() const noexcept {
     const auto ui_cam_pos = Vector2::Zero;
     g_theRenderer->BeginHUDRender(m_ui_camera2D, ui_cam_pos, ui_view_height);
 
+    RenderLeaderboard(-ui_view_half_extents);
 }
 
 void Game::EndFrame() noexcept {
@@ -222,6 +267,130 @@ void Game::HandleKeyboardInput(TimeUtils::FPSeconds deltaSeconds) {
     }
 }
 
+AABB2 Game::CalcWorldViewBounds() const noexcept {
+    const auto dims = Vector2{g_theRenderer->GetOutput()->GetDimensions()};
+    const auto corners = std::array<Vector2, 4>{
+        Vector2{g_theRenderer->ConvertScreenToWorldCoords(Vector2::Zero)},
+        Vector2{g_theRenderer->ConvertScreenToWorldCoords(Vector2{dims.x, 0.0f})},
+        Vector2{g_theRenderer->ConvertScreenToWorldCoords(Vector2{0.0f, dims.y})},
+        Vector2{g_theRenderer->ConvertScreenToWorldCoords(dims)}
+    };
+    AABB2 bounds{corners[0], corners[0]};
+    for(const auto& corner : corners) {
+        bounds.mins.x = (std::min)(bounds.mins.x, corner.x);
+        bounds.mins.y = (std::min)(bounds.mins.y, corner.y);
+        bounds.maxs.x = (std::max)(bounds.maxs.x, corner.x);
+        bounds.maxs.y = (std::max)(bounds.maxs.y, corner.y);
+    }
+    return bounds;
+}
+
+void Game::Respawn() noexcept {
+    m_lander->SetPosition(m_level.GetSpawnPosition());
+    if(const auto spawns = m_level.GetSpawns(); !spawns.empty()) {
+        m_lander->SetFuel(spawns.front().fuelPounds);
+    }
+    m_lastLanderPosition = m_lander->GetPosition();
+    m_windSeconds = 0.0f;
+    m_collectedFuel.assign(m_level.GetFuelPickups().size(), false);
+    m_ghost.clear();
+    m_ghostSeconds = 0.0f;
+}
+
+void Game::RecordGhostFrames(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    //Sampled on the store's fixed tick so a replay runs at the same speed on any frame rate.
+    m_ghostSeconds += deltaSeconds.count();
+    while(m_ghostSeconds >= ScoreFormat::GhostTickSeconds) {
+        m_ghostSeconds -= ScoreFormat::GhostTickSeconds;
+        m_ghost.push_back(GhostFrame{m_lander->GetPosition(), m_lander->GetOrientationDegrees()});
+    }
+}
+
+void Game::UpdateRun() noexcept {
+    const auto position = m_lander->GetPosition();
+    const auto previous = std::exchange(m_lastLanderPosition, position);
+    for(const auto& pad : m_level.GetPadsInRange(position.x, position.x)) {
+        if(previous.y < pad.y && position.y >= pad.y) {
+            EndRunOnPad(pad);
+            return;
+        }
+    }
+    CollectFuel(position);
+    const auto ground = m_level.CalcGroundHeight(position.x);
+    const auto ceiling = m_level.GetSpawnPosition().y - CeilingHeightAboveSpawn;
+    const auto has_crashed = ground && position.y >= *ground;
+    const auto is_out_of_bounds = !ground || position.y < ceiling;
+    if(has_crashed || is_out_of_bounds || m_ghost.size() >= MaxGhostFrames) {
+        Respawn();
+    }
+}
+
+void Game::CollectFuel(const Vector2& position) noexcept {
+    const auto pickups = m_level.GetFuelPickups();
+    for(const auto& pickup : m_level.GetFuelPickupsInRange(position.x - FuelPickupRadius, position.x + FuelPickupRadius)) {
+        const auto index = static_cast<std::size_t>(&pickup - pickups.data());
+        if(m_collectedFuel[index] || (Vector2{pickup.x, pickup.y} - position).CalcLength() > FuelPickupRadius) {
+            continue;
+        }
+        m_collectedFuel[index] = true;
+        m_lander->SetFuel(m_lander->GetFuel() + pickup.fuelPounds);
+    }
+}
+
+void Game::EndRunOnPad(const LevelFormat::LandingPad& pad) noexcept {
+    const auto speed = m_lander->GetVelocity().CalcLength();
+    const auto tilt = std::abs(std::remainder(m_lander->GetOrientationDegrees(), 360.0f));
+    if(speed > MaxLandingSpeed || tilt > MaxLandingTiltDegrees) {
+        Respawn();
+        return;
+    }
+    RunResult run{};
+    run.levelId = m_levelId;
+    run.player = m_playerName;
+    run.touchdownSpeed = speed;
+    run.fuelLeft = m_lander->GetFuel();
+    const auto fuel_bonus = 1000.0f * run.fuelLeft;
+    const auto soft_landing_bonus = 1000.0f * (1.0f - speed / MaxLandingSpeed);
+    //Clamped before the cast: a mapped level is not trusted to carry a sane multiplier.
+    const auto score = static_cast<double>(pad.scoreMultiplier) * (1000.0 + fuel_bonus + soft_landing_bonus);
+    run.score = std::isnan(score) ? 0u : static_cast<uint32_t>(std::clamp(score, 0.0, static_cast<double>((std::numeric_limits<uint32_t>::max)())));
+    run.ghost = std::move(m_ghost);
+    m_scores->Submit(std::move(run));
+    Respawn();
+}
+
+void Game::RefreshLeaderboard() noexcept {
+    m_leaderboard = m_scores->GetTopScores(m_levelId, LeaderboardSize);
+    m_bestGhost = m_leaderboard.empty() ? std::vector<GhostFrame>{} : m_scores->GetGhost(m_leaderboard.front().runId).value_or(std::vector<GhostFrame>{});
+    m_personalBest = m_scores->GetPersonalBest(m_levelId, m_playerName);
+}
+
+void Game::RenderLeaderboard(const Vector2& topLeft) const noexcept {
+    auto* font = g_theRenderer->GetFont("System32");
+    if(!font) {
+        return;
+    }
+    std::string text{"Leaderboard\n"};
+    for(std::size_t i = 0u; i < m_leaderboard.size(); ++i) {
+        text += std::to_string(i + 1u) + ". " + m_leaderboard[i].player + "  " + std::to_string(m_leaderboard[i].score) + '\n';
+    }
+    text += "Personal best: " + (m_personalBest ? std::to_string(m_personalBest->score) : std::string{"-"});
+    const auto padding = Vector2{font->CalcLineHeight(), font->CalcLineHeight()};
+    g_theRenderer->SetModelMatrix(Matrix4::CreateTranslationMatrix(topLeft + padding));
+    g_theRenderer->DrawMultilineText(font, text);
+}
+
+void Game::DebugRenderBestGhost() const noexcept {
+    if(m_bestGhost.size() < 2u) {
+        return;
+    }
+    g_theRenderer->SetMaterial("__2D");
+    g_theRenderer->SetModelMatrix(Matrix4::I);
+    for(std::size_t i = 1u; i < m_bestGhost.size(); ++i) {
+        g_theRenderer->DrawLine2D(m_bestGhost[i - 1].position, m_bestGhost[i].position, Rgba::Green);
+    }
+}
+
 void Game::HandleControllerInput(TimeUtils::FPSeconds /*deltaSeconds*/) {
 
 }
@@ -9,8 +9,13 @@
 #include "Engine/Renderer/SpriteSheet.hpp"
 
 #include "Game/Lander.hpp"
+#include "Game/Level.hpp"
+#include "Game/ScoreStore.hpp"
 
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 class GameOptions : public GameSettings {
 public:
@@ -89,11 +94,35 @@ private:
     void HandleControllerInput(TimeUtils::FPSeconds deltaSeconds);
     void HandleMouseInput(TimeUtils::FPSeconds deltaSeconds);
 
+    AABB2 CalcWorldViewBounds() const noexcept;
+
+    void Respawn() noexcept;
+    void RecordGhostFrames(TimeUtils::FPSeconds deltaSeconds) noexcept;
+    void UpdateRun() noexcept;
+    void CollectFuel(const Vector2& position) noexcept;
+    void EndRunOnPad(const LevelFormat::LandingPad& pad) noexcept;
+    void RefreshLeaderboard() noexcept;
+    void RenderLeaderboard(const Vector2& topLeft) const noexcept;
+    void DebugRenderBestGhost() const noexcept;
+
     mutable Camera2D m_ui_camera2D{};
     mutable OrthographicCameraController m_cameraController{};
     GameOptions m_settings{};
     std::shared_ptr<SpriteSheet> m_landerSheet{};
     std::unique_ptr<Lander> m_lander{};
+    Level m_level{};
+    float m_windSeconds{0.0f};
+    std::unique_ptr<ScoreStore> m_scores{};
+    std::vector<bool> m_collectedFuel{};
+    std::vector<GhostFrame> m_ghost{};
+    float m_ghostSeconds{0.0f};
+    std::vector<GhostFrame> m_bestGhost{};
+    std::vector<ScoreEntry> m_leaderboard{};
+    std::optional<ScoreEntry> m_personalBest{};
+    uint64_t m_scoreChangeCount{0u};
+    std::string m_playerName{"PLAYER"};
+    Vector2 m_lastLanderPosition{};
+    uint32_t m_levelId{0u};
     bool m_debug_render{ false };
     bool m_lockPositionToMouse{ false };
     bool m_lockCameraRotation{ false };
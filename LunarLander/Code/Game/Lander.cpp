@@ -12,6 +12,7 @@
 
 #include "Engine/Core/DataUtils.hpp"
 
+#include <algorithm>
 #include <string>
 
 Lander::Lander() noexcept {
@@ -65,7 +66,8 @@ R"(
         RigidBodyDesc desc{};
         desc.physicsDesc = PhysicsDesc{};
         desc.physicsDesc.angularDamping = 1.0f;
-        desc.physicsDesc.enableGravity = true;
+        //Gravity comes from the level and is applied in Update.
+        desc.physicsDesc.enableGravity = false;
         desc.physicsDesc.enablePhysics = true;
         desc.collider = new ColliderOBB(Vector2::Zero, Vector2::One * 23.0f);
         m_body = RigidBody{ desc };
@@ -79,9 +81,11 @@ void Lander::BeginFrame() noexcept {
 }
 
 void Lander::Update(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    ApplyAcceleration(Vector2::Y_Axis, m_gravity, deltaSeconds);
     if(m_isThrusting && HasFuel()) {
         //m_currentSprite->Resume();
         m_body.ApplyImpulse(-Vector2::Y_Axis, m_thrustForceKiloNewtons * 1000.0f);
+        m_fuelPounds = (std::max)(0.0f, m_fuelPounds - m_fuelBurnPoundsPerSecond * deltaSeconds.count());
     } else {
         m_currentSprite = m_noThrustSprite.get();
     }
@@ -189,6 +193,10 @@ const Vector2 Lander::GetPosition() const noexcept {
     return m_body.GetPosition();
 }
 
+const Vector2 Lander::GetVelocity() const noexcept {
+    return m_body.GetVelocity();
+}
+
 void Lander::SetPosition(const Vector2& newPosition) noexcept {
     m_body.SetPosition(newPosition, true);
 }
@@ -205,7 +213,30 @@ const Matrix4& Lander::GetTransform() const noexcept {
     return m_body.transform;
 }
 
+void Lander::ApplyWind(float windSpeed, TimeUtils::FPSeconds deltaSeconds) noexcept {
+    ApplyAcceleration(Vector2::X_Axis, windSpeed, deltaSeconds);
+}
+
+void Lander::SetGravity(float gravity) noexcept {
+    m_gravity = gravity;
+}
+
+void Lander::ApplyAcceleration(const Vector2& direction, float acceleration, TimeUtils::FPSeconds deltaSeconds) noexcept {
+    if(MathUtils::IsEquivalentToZero(acceleration)) {
+        return;
+    }
+    m_body.ApplyImpulse(direction, acceleration * m_body.GetMass() * deltaSeconds.count());
+}
+
 bool Lander::HasFuel() const noexcept {
     return m_fuelPounds > 0.0f;
 }
 
+float Lander::GetFuel() const noexcept {
+    return m_fuelPounds;
+}
+
+void Lander::SetFuel(float fuelPounds) noexcept {
+    m_fuelPounds = fuelPounds;
+}
+
@@ -33,6 +33,7 @@ public:
     void EndThrust() noexcept;
 
     const Vector2 GetPosition() const noexcept;
+    const Vector2 GetVelocity() const noexcept;
     void SetPosition(const Vector2& newPosition) noexcept;
 
     const float GetOrientationDegrees() const noexcept;
@@ -40,9 +41,16 @@ public:
 
     const Matrix4& GetTransform() const noexcept;
 
+    void ApplyWind(float windSpeed, TimeUtils::FPSeconds deltaSeconds) noexcept;
+    void SetGravity(float gravity) noexcept;
+
     bool HasFuel() const noexcept;
+    float GetFuel() const noexcept;
+    void SetFuel(float fuelPounds) noexcept;
 protected:
 private:
+    void ApplyAcceleration(const Vector2& direction, float acceleration, TimeUtils::FPSeconds deltaSeconds) noexcept;
+
     static inline std::unique_ptr<AnimatedSprite> m_sprite{};
     static inline std::unique_ptr<AnimatedSprite> m_noThrustSprite{};
     AnimatedSprite* m_currentSprite{ nullptr };
@@ -55,6 +63,8 @@ private:
     float m_rotationSpeedDegrees{1.0f};
     float m_deltaOrientation{0.0f};
     float m_fuelPounds{1.0f};
+    float m_fuelBurnPoundsPerSecond{0.05f};
+    float m_gravity{9.81f};
     const float m_thrustForceKiloNewtons{10.0f};
     bool m_isThrusting{ false };
 };
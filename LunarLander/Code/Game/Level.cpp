@@ -0,0 +1,155 @@
+#include "Game/Level.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace {
+
+bool IsSectionInBounds(const LevelFormat::Section& section, std::size_t recordSize, uint64_t fileSize) noexcept {
+    if(section.offset % LevelFormat::SectionAlignment) {
+        return false;
+    }
+    if(section.count && section.offset < sizeof(LevelFormat::Header)) {
+        return false;
+    }
+    const auto end = static_cast<uint64_t>(section.offset) + static_cast<uint64_t>(section.count) * recordSize;
+    return end <= fileSize;
+}
+
+} // namespace
+
+Level::Level(const std::filesystem::path& filepath) noexcept
+: m_file{filepath}
+{
+    if(!m_file.IsOpen()) {
+        g_theFileLogger->LogWarnLine("Level " + filepath.string() + " could not be opened.");
+        return;
+    }
+    if(!Validate()) {
+        g_theFileLogger->LogWarnLine("Level " + filepath.string() + " is not a valid version " + std::to_string(LevelFormat::Version) + " level file.");
+        m_file = MappedFile{};
+    }
+}
+
+bool Level::Validate() const noexcept {
+    if(m_file.GetSize() < sizeof(LevelFormat::Header)) {
+        return false;
+    }
+    const auto& header = *m_file.GetAs<LevelFormat::Header>();
+    if(header.magic != LevelFormat::Magic || header.version != LevelFormat::Version || header.fileSize != m_file.GetSize()) {
+        return false;
+    }
+    return IsSectionInBounds(header.terrain, sizeof(LevelFormat::TerrainSegment), header.fileSize)
+           && IsSectionInBounds(header.pads, sizeof(LevelFormat::LandingPad), header.fileSize)
+           && IsSectionInBounds(header.spawns, sizeof(LevelFormat::SpawnPoint), header.fileSize)
+           && IsSectionInBounds(header.fuel, sizeof(LevelFormat::FuelPickup), header.fileSize);
+}
+
+void Level::Render(const AABB2& visibleBounds, const std::vector<bool>& collectedFuel) const noexcept {
+    if(!IsLoaded()) {
+        return;
+    }
+    g_theRenderer->SetMaterial("__2D");
+    g_theRenderer->SetModelMatrix(Matrix4::I);
+    for(const auto& segment : GetTerrainInRange(visibleBounds.mins.x, visibleBounds.maxs.x)) {
+        g_theRenderer->DrawLine2D(Vector2{segment.startX, segment.startY}, Vector2{segment.endX, segment.endY}, Rgba::LightGray);
+    }
+    for(const auto& pad : GetPadsInRange(visibleBounds.mins.x, visibleBounds.maxs.x)) {
+        g_theRenderer->DrawLine2D(Vector2{pad.minX, pad.y}, Vector2{pad.maxX, pad.y}, Rgba::Green, 2.0f);
+    }
+    const auto pickups = GetFuelPickups();
+    for(const auto& pickup : GetFuelPickupsInRange(visibleBounds.mins.x, visibleBounds.maxs.x)) {
+        const auto index = static_cast<std::size_t>(&pickup - pickups.data());
+        if(index < collectedFuel.size() && collectedFuel[index]) {
+            continue;
+        }
+        const auto bounds = AABB2{Vector2{pickup.x - 4.0f, pickup.y - 4.0f}, Vector2{pickup.x + 4.0f, pickup.y + 4.0f}};
+        g_theRenderer->DrawAABB2(bounds, Rgba::White, Rgba::Green, Vector2::One);
+    }
+}
+
+bool Level::IsLoaded() const noexcept {
+    return m_file.IsOpen();
+}
+
+const LevelFormat::Header* Level::GetHeader() const noexcept {
+    return m_file.GetAs<LevelFormat::Header>();
+}
+
+const LevelFormat::Environment& Level::GetEnvironment() const noexcept {
+    static const LevelFormat::Environment no_environment{};
+    return IsLoaded() ? GetHeader()->environment : no_environment;
+}
+
+//Gusts swing the base wind by up to windVariance on a fixed period,
+//measured from the start of the run.
+float Level::CalcWindSpeed(float elapsedSeconds) const noexcept {
+    constexpr float gust_period_seconds = 4.0f;
+    const auto& environment = GetEnvironment();
+    const auto phase = elapsedSeconds / gust_period_seconds * 2.0f * 3.14159265f;
+    return environment.windSpeed + environment.windVariance * std::sin(phase);
+}
+
+const Vector2 Level::GetSpawnPosition(std::size_t index /*= 0u*/) const noexcept {
+    const auto spawns = GetSpawns();
+    if(index >= spawns.size()) {
+        return Vector2::Zero;
+    }
+    return Vector2{spawns[index].x, spawns[index].y};
+}
+
+std::optional<float> Level::CalcGroundHeight(float x) const noexcept {
+    const auto segments = GetTerrainInRange(x, x);
+    if(segments.empty()) {
+        return {};
+    }
+    const auto& segment = segments.front();
+    const auto width = segment.endX - segment.startX;
+    if(width <= 0.0f) {
+        return (std::max)(segment.startY, segment.endY);
+    }
+    const auto t = std::clamp((x - segment.startX) / width, 0.0f, 1.0f);
+    return segment.startY + (segment.endY - segment.startY) * t;
+}
+
+std::span<const LevelFormat::TerrainSegment> Level::GetTerrain() const noexcept {
+    return GetSection<LevelFormat::TerrainSegment>(&LevelFormat::Header::terrain);
+}
+
+std::span<const LevelFormat::LandingPad> Level::GetPads() const noexcept {
+    return GetSection<LevelFormat::LandingPad>(&LevelFormat::Header::pads);
+}
+
+std::span<const LevelFormat::SpawnPoint> Level::GetSpawns() const noexcept {
+    return GetSection<LevelFormat::SpawnPoint>(&LevelFormat::Header::spawns);
+}
+
+std::span<const LevelFormat::FuelPickup> Level::GetFuelPickups() const noexcept {
+    return GetSection<LevelFormat::FuelPickup>(&LevelFormat::Header::fuel);
+}
+
+std::span<const LevelFormat::TerrainSegment> Level::GetTerrainInRange(float minX, float maxX) const noexcept {
+    const auto terrain = GetTerrain();
+    const auto first = std::partition_point(std::begin(terrain), std::end(terrain), [minX](const auto& segment) { return segment.endX < minX; });
+    const auto last = std::partition_point(first, std::end(terrain), [maxX](const auto& segment) { return segment.startX <= maxX; });
+    return std::span<const LevelFormat::TerrainSegment>{first, last};
+}
+
+std::span<const LevelFormat::LandingPad> Level::GetPadsInRange(float minX, float maxX) const noexcept {
+    const auto pads = GetPads();
+    const auto first = std::partition_point(std::begin(pads), std::end(pads), [minX](const auto& pad) { return pad.maxX < minX; });
+    const auto last = std::partition_point(first, std::end(pads), [maxX](const auto& pad) { return pad.minX <= maxX; });
+    return std::span<const LevelFormat::LandingPad>{first, last};
+}
+
+std::span<const LevelFormat::FuelPickup> Level::GetFuelPickupsInRange(float minX, float maxX) const noexcept {
+    const auto fuel = GetFuelPickups();
+    const auto first = std::partition_point(std::begin(fuel), std::end(fuel), [minX](const auto& pickup) { return pickup.x < minX; });
+    const auto last = std::partition_point(first, std::end(fuel), [maxX](const auto& pickup) { return pickup.x <= maxX; });
+    return std::span<const LevelFormat::FuelPickup>{first, last};
+}
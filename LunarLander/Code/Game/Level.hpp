@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vector2.hpp"
+
+#include "Game/MappedFile.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace LevelFormat {
+
+// On-disk layout of a compiled .level file. Every record is plain old data
+// so the mapped file can be read in place without any parsing or copying.
+// Sections start on SectionAlignment boundaries. Terrain segments, pads and
+// fuel pickups are sorted by their minimum x so a camera range can be binary
+// searched and only the pages under the camera are ever faulted in.
+
+constexpr std::array<char, 4> Magic{'L', 'L', 'V', 'L'};
+constexpr uint32_t Version = 1u;
+constexpr std::size_t SectionAlignment = 16u;
+
+struct Section {
+    uint32_t offset{0u};
+    uint32_t count{0u};
+};
+
+struct Environment {
+    float gravity{0.0f};
+    float windSpeed{0.0f};
+    float windVariance{0.0f};
+    uint32_t reserved{0u};
+};
+
+struct Header {
+    std::array<char, 4> magic{Magic};
+    uint32_t version{Version};
+    uint64_t fileSize{0u};
+    Environment environment{};
+    Section terrain{};
+    Section pads{};
+    Section spawns{};
+    Section fuel{};
+};
+
+struct TerrainSegment {
+    float startX{0.0f};
+    float startY{0.0f};
+    float endX{0.0f};
+    float endY{0.0f};
+};
+
+struct LandingPad {
+    float minX{0.0f};
+    float maxX{0.0f};
+    float y{0.0f};
+    float scoreMultiplier{1.0f};
+};
+
+struct SpawnPoint {
+    float x{0.0f};
+    float y{0.0f};
+    float fuelPounds{0.0f};
+    uint32_t reserved{0u};
+};
+
+struct FuelPickup {
+    float x{0.0f};
+    float y{0.0f};
+    float fuelPounds{0.0f};
+    uint32_t reserved{0u};
+};
+
+static_assert(sizeof(Header) == 64u && alignof(Header) <= SectionAlignment);
+static_assert(sizeof(TerrainSegment) == 16u && std::is_trivially_copyable_v<TerrainSegment>);
+static_assert(sizeof(LandingPad) == 16u && std::is_trivially_copyable_v<LandingPad>);
+static_assert(sizeof(SpawnPoint) == 16u && std::is_trivially_copyable_v<SpawnPoint>);
+static_assert(sizeof(FuelPickup) == 16u && std::is_trivially_copyable_v<FuelPickup>);
+
+} // namespace LevelFormat
+
+class Level {
+public:
+    Level() noexcept = default;
+    explicit Level(const std::filesystem::path& filepath) noexcept;
+    Level(const Level& other) = delete;
+    Level(Level&& other) noexcept = default;
+    Level& operator=(const Level& other) = delete;
+    Level& operator=(Level&& other) noexcept = default;
+    ~Level() noexcept = default;
+
+    //collectedFuel is indexed like GetFuelPickups(); collected pickups are not drawn.
+    void Render(const AABB2& visibleBounds, const std::vector<bool>& collectedFuel) const noexcept;
+
+    bool IsLoaded() const noexcept;
+
+    const LevelFormat::Environment& GetEnvironment() const noexcept;
+    float CalcWindSpeed(float elapsedSeconds) const noexcept;
+    const Vector2 GetSpawnPosition(std::size_t index = 0u) const noexcept;
+    std::optional<float> CalcGroundHeight(float x) const noexcept;
+
+    std::span<const LevelFormat::TerrainSegment> GetTerrain() const noexcept;
+    std::span<const LevelFormat::LandingPad> GetPads() const noexcept;
+    std::span<const LevelFormat::SpawnPoint> GetSpawns() const noexcept;
+    std::span<const LevelFormat::FuelPickup> GetFuelPickups() const noexcept;
+
+    std::span<const LevelFormat::TerrainSegment> GetTerrainInRange(float minX, float maxX) const noexcept;
+    std::span<const LevelFormat::LandingPad> GetPadsInRange(float minX, float maxX) const noexcept;
+    std::span<const LevelFormat::FuelPickup> GetFuelPickupsInRange(float minX, float maxX) const noexcept;
+
+protected:
+private:
+    [[nodiscard]] bool Validate() const noexcept;
+
+    const LevelFormat::Header* GetHeader() const noexcept;
+
+    template<typename T>
+    std::span<const T> GetSection(LevelFormat::Section LevelFormat::Header::*section) const noexcept;
+
+    MappedFile m_file{};
+};
+
+template<typename T>
+std::span<const T> Level::GetSection(LevelFormat::Section LevelFormat::Header::*section) const noexcept {
+    if(!IsLoaded()) {
+        return {};
+    }
+    const auto& s = GetHeader()->*section;
+    return m_file.GetArray<T>(s.offset, s.count);
+}
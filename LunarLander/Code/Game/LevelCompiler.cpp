@@ -0,0 +1,145 @@
+#include "Game/LevelCompiler.hpp"
+
+#include "Engine/Core/DataUtils.hpp"
+
+#include "Game/Level.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template<typename T>
+LevelFormat::Section AppendSection(std::vector<std::byte>& buffer, const std::vector<T>& records) noexcept {
+    const auto aligned_offset = (buffer.size() + LevelFormat::SectionAlignment - 1u) & ~(LevelFormat::SectionAlignment - 1u);
+    const auto byte_count = records.size() * sizeof(T);
+    buffer.resize(aligned_offset + byte_count);
+    if(byte_count) {
+        std::memcpy(buffer.data() + aligned_offset, records.data(), byte_count);
+    }
+    return LevelFormat::Section{static_cast<uint32_t>(aligned_offset), static_cast<uint32_t>(records.size())};
+}
+
+bool IsLevelSource(const std::filesystem::path& p) noexcept {
+    return p.extension() == ".xml" && p.stem().extension() == ".level";
+}
+
+} // namespace
+
+namespace LevelCompiler {
+
+bool CompileFromXml(const std::filesystem::path& src, const std::filesystem::path& dest, std::ostream& errors) noexcept {
+    tinyxml2::XMLDocument doc;
+    if(doc.LoadFile(src.string().c_str()) != tinyxml2::XML_SUCCESS) {
+        errors << "Level source " << src.string() << " could not be parsed.\n";
+        return false;
+    }
+    const auto* xml_root = doc.RootElement();
+    if(!xml_root || std::string{xml_root->Name()} != "level") {
+        errors << "Level source " << src.string() << " does not have a <level> root element.\n";
+        return false;
+    }
+
+    LevelFormat::Header header{};
+    header.environment.gravity = xml_root->FloatAttribute("gravity", 0.0f);
+    header.environment.windSpeed = xml_root->FloatAttribute("windSpeed", 0.0f);
+    header.environment.windVariance = xml_root->FloatAttribute("windVariance", 0.0f);
+
+    std::vector<LevelFormat::TerrainSegment> terrain{};
+    if(const auto* xml_terrain = xml_root->FirstChildElement("terrain"); xml_terrain != nullptr) {
+        std::vector<Vector2> points{};
+        for(auto* xml_point = xml_terrain->FirstChildElement("point"); xml_point != nullptr; xml_point = xml_point->NextSiblingElement("point")) {
+            points.emplace_back(xml_point->FloatAttribute("x", 0.0f), xml_point->FloatAttribute("y", 0.0f));
+        }
+        std::stable_sort(std::begin(points), std::end(points), [](const Vector2& a, const Vector2& b) { return a.x < b.x; });
+        for(std::size_t i = 1u; i < points.size(); ++i) {
+            terrain.push_back(LevelFormat::TerrainSegment{points[i - 1].x, points[i - 1].y, points[i].x, points[i].y});
+        }
+    }
+
+    std::vector<LevelFormat::LandingPad> pads{};
+    for(auto* xml_pad = xml_root->FirstChildElement("pad"); xml_pad != nullptr; xml_pad = xml_pad->NextSiblingElement("pad")) {
+        auto pad = LevelFormat::LandingPad{xml_pad->FloatAttribute("minX", 0.0f), xml_pad->FloatAttribute("maxX", 0.0f), xml_pad->FloatAttribute("y", 0.0f), xml_pad->FloatAttribute("multiplier", 1.0f)};
+        if(pad.maxX < pad.minX) {
+            std::swap(pad.minX, pad.maxX);
+        }
+        if(!std::isfinite(pad.scoreMultiplier) || pad.scoreMultiplier <= 0.0f) {
+            errors << "Level source " << src.string() << " has a pad at x=" << pad.minX << " with multiplier " << pad.scoreMultiplier << ". Multipliers must be positive.\n";
+            return false;
+        }
+        pads.push_back(pad);
+    }
+    std::sort(std::begin(pads), std::end(pads), [](const auto& a, const auto& b) { return a.minX < b.minX; });
+    const auto overlap = std::adjacent_find(std::begin(pads), std::end(pads), [](const auto& a, const auto& b) { return b.minX < a.maxX; });
+    if(overlap != std::end(pads)) {
+        errors << "Level source " << src.string() << " has overlapping pads at x=" << overlap->minX << ". Pads must not overlap.\n";
+        return false;
+    }
+
+    std::vector<LevelFormat::SpawnPoint> spawns{};
+    for(auto* xml_spawn = xml_root->FirstChildElement("spawn"); xml_spawn != nullptr; xml_spawn = xml_spawn->NextSiblingElement("spawn")) {
+        spawns.push_back(LevelFormat::SpawnPoint{xml_spawn->FloatAttribute("x", 0.0f), xml_spawn->FloatAttribute("y", 0.0f), xml_spawn->FloatAttribute("fuel", 1.0f)});
+    }
+
+    std::vector<LevelFormat::FuelPickup> fuel{};
+    for(auto* xml_fuel = xml_root->FirstChildElement("fuel"); xml_fuel != nullptr; xml_fuel = xml_fuel->NextSiblingElement("fuel")) {
+        fuel.push_back(LevelFormat::FuelPickup{xml_fuel->FloatAttribute("x", 0.0f), xml_fuel->FloatAttribute("y", 0.0f), xml_fuel->FloatAttribute("pounds", 0.0f)});
+    }
+    std::sort(std::begin(fuel), std::end(fuel), [](const auto& a, const auto& b) { return a.x < b.x; });
+
+    std::vector<std::byte> buffer(sizeof(LevelFormat::Header));
+    header.terrain = AppendSection(buffer, terrain);
+    header.pads = AppendSection(buffer, pads);
+    header.spawns = AppendSection(buffer, spawns);
+    header.fuel = AppendSection(buffer, fuel);
+    header.fileSize = buffer.size();
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    auto tmp = dest;
+    tmp += ".tmp";
+    {
+        std::ofstream ofs{tmp, std::ios_base::binary | std::ios_base::trunc};
+        ofs.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if(!ofs) {
+            errors << "Level " << dest.string() << " could not be written.\n";
+            return false;
+        }
+    }
+    std::error_code ec{};
+    std::filesystem::rename(tmp, dest, ec);
+    if(ec) {
+        errors << "Level " << dest.string() << " could not be replaced: " << ec.message() << '\n';
+        return false;
+    }
+    return true;
+}
+
+std::size_t CompileFolder(const std::filesystem::path& folder, std::ostream& errors) noexcept {
+    namespace FS = std::filesystem;
+    std::size_t failed_count = 0u;
+    std::error_code ec{};
+    for(auto iter = FS::directory_iterator{folder, ec}; !ec && iter != FS::directory_iterator{}; iter.increment(ec)) {
+        const auto& src = iter->path();
+        if(!IsLevelSource(src)) {
+            continue;
+        }
+        auto dest = src;
+        dest.replace_extension();
+        if(!CompileFromXml(src, dest, errors)) {
+            ++failed_count;
+        }
+    }
+    if(ec) {
+        errors << "Level folder " << folder.string() << " could not be read: " << ec.message() << '\n';
+        ++failed_count;
+    }
+    return failed_count;
+}
+
+} // namespace LevelCompiler
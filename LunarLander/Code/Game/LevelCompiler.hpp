@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <ostream>
+
+//Offline converter from *.level.xml sources to the mapped .level format.
+//Run with LunarLander.exe -compile-levels; the game itself only maps the
+//compiled files, so nothing here runs before the first frame.
+namespace LevelCompiler {
+
+[[nodiscard]] bool CompileFromXml(const std::filesystem::path& src, const std::filesystem::path& dest, std::ostream& errors) noexcept;
+
+//Returns the number of sources that failed to compile.
+std::size_t CompileFolder(const std::filesystem::path& folder, std::ostream& errors) noexcept;
+
+} // namespace LevelCompiler
@@ -4,20 +4,42 @@
 #include "Engine/Platform/Win.hpp"
 
 #include "Game/Game.hpp"
+#include "Game/LevelCompiler.hpp"
 
+#include <cstdio>
+#include <iostream>
 #include <string>
+#include <string_view>
 
 #pragma warning(push)
 #pragma warning(disable: 28251)
 
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int nCmdShow);
 
+namespace {
+
+//Compiles Data/Definitions/*.level.xml into the .level files the game maps.
+//Errors go to the console the tool was started from, if any.
+int CompileLevels() noexcept {
+    if(::AttachConsole(ATTACH_PARENT_PROCESS)) {
+        FILE* console{};
+        ::freopen_s(&console, "CONOUT$", "w", stderr);
+    }
+    const auto failed_count = LevelCompiler::CompileFolder("Data/Definitions", std::cerr);
+    std::cerr.flush();
+    return failed_count ? 1 : 0;
+}
+
+} // namespace
+
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int nCmdShow) {
     using namespace std::literals::string_literals;
     UNUSED(hInstance);
     UNUSED(hPrevInstance);
     UNUSED(nCmdShow);
-    UNUSED(pCmdLine);
+    if(pCmdLine && std::wstring_view{pCmdLine}.find(L"-compile-levels") != std::wstring_view::npos) {
+        return CompileLevels();
+    }
     Engine<Game>::Initialize("Lunar Lander"s);
     Engine<Game>::Run();
     Engine<Game>::Shutdown();
@@ -0,0 +1,81 @@
+#include "Game/MappedFile.hpp"
+
+#include "Engine/Platform/Win.hpp"
+
+#include <utility>
+
+MappedFile::MappedFile(const std::filesystem::path& filepath) noexcept {
+    m_file = ::CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if(m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        return;
+    }
+    LARGE_INTEGER size{};
+    if(!::GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+        Close();
+        return;
+    }
+    m_mapping = ::CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!m_mapping) {
+        Close();
+        return;
+    }
+    m_view = static_cast<const std::byte*>(::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if(!m_view) {
+        Close();
+        return;
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+: m_file{std::exchange(other.m_file, nullptr)}
+, m_mapping{std::exchange(other.m_mapping, nullptr)}
+, m_view{std::exchange(other.m_view, nullptr)}
+, m_size{std::exchange(other.m_size, 0u)}
+{
+    /* DO NOTHING */
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if(this != &other) {
+        Close();
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_view = std::exchange(other.m_view, nullptr);
+        m_size = std::exchange(other.m_size, 0u);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() noexcept {
+    Close();
+}
+
+void MappedFile::Close() noexcept {
+    if(m_view) {
+        ::UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    if(m_mapping) {
+        ::CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if(m_file) {
+        ::CloseHandle(m_file);
+        m_file = nullptr;
+    }
+    m_size = 0u;
+}
+
+bool MappedFile::IsOpen() const noexcept {
+    return m_view != nullptr;
+}
+
+const std::byte* MappedFile::GetData() const noexcept {
+    return m_view;
+}
+
+std::size_t MappedFile::GetSize() const noexcept {
+    return m_size;
+}
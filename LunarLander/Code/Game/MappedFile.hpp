@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+class MappedFile {
+public:
+    MappedFile() noexcept = default;
+    explicit MappedFile(const std::filesystem::path& filepath) noexcept;
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile() noexcept;
+
+    bool IsOpen() const noexcept;
+    const std::byte* GetData() const noexcept;
+    std::size_t GetSize() const noexcept;
+
+    template<typename T>
+    const T* GetAs(std::size_t offset = 0u) const noexcept;
+
+    template<typename T>
+    std::span<const T> GetArray(std::size_t offset, std::size_t count) const noexcept;
+
+protected:
+private:
+    void Close() noexcept;
+
+    void* m_file{nullptr};
+    void* m_mapping{nullptr};
+    const std::byte* m_view{nullptr};
+    std::size_t m_size{0u};
+};
+
+template<typename T>
+const T* MappedFile::GetAs(std::size_t offset /*= 0u*/) const noexcept {
+    return reinterpret_cast<const T*>(m_view + offset);
+}
+
+template<typename T>
+std::span<const T> MappedFile::GetArray(std::size_t offset, std::size_t count) const noexcept {
+    return std::span<const T>{GetAs<T>(offset), count};
+}
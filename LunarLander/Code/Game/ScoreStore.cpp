@@ -0,0 +1,888 @@
+#include "Game/ScoreStore.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/Platform/Win.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+constexpr float GhostQuantization = 16.0f;
+
+uint32_t CalcCrc32(uint32_t crc, const std::byte* data, std::size_t size) noexcept {
+    static const auto table = []() {
+        std::array<uint32_t, 256> result{};
+        for(uint32_t i = 0u; i < 256u; ++i) {
+            auto c = i;
+            for(int bit = 0; bit < 8; ++bit) {
+                c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            result[i] = c;
+        }
+        return result;
+    }();
+    crc = ~crc;
+    for(std::size_t i = 0u; i < size; ++i) {
+        crc = table[(crc ^ static_cast<uint32_t>(data[i])) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t CalcRecordChecksum(const ScoreFormat::RunRecord& record, const std::vector<std::byte>& ghost) noexcept {
+    constexpr auto checked_offset = offsetof(ScoreFormat::RunRecord, levelId);
+    const auto* bytes = reinterpret_cast<const std::byte*>(&record);
+    const auto crc = CalcCrc32(0u, bytes + checked_offset, sizeof(record) - checked_offset);
+    return CalcCrc32(crc, ghost.data(), ghost.size());
+}
+
+ScoreFormat::PlayerName ToPlayerName(const std::string& player) noexcept {
+    ScoreFormat::PlayerName result{};
+    std::copy_n(std::begin(player), (std::min)(player.size(), result.size()), std::begin(result));
+    return result;
+}
+
+std::string FromPlayerName(const ScoreFormat::PlayerName& player) noexcept {
+    const auto last = std::find(std::begin(player), std::end(player), '\0');
+    return std::string{std::begin(player), last};
+}
+
+bool IsRankedBefore(const ScoreFormat::IndexEntry& a, const ScoreFormat::IndexEntry& b) noexcept {
+    if(a.levelId != b.levelId) {
+        return a.levelId < b.levelId;
+    }
+    if(a.score != b.score) {
+        return a.score > b.score;
+    }
+    return a.logOffset < b.logOffset;
+}
+
+bool IsPlayerBefore(const ScoreFormat::IndexEntry& a, const ScoreFormat::IndexEntry& b) noexcept {
+    if(a.levelId != b.levelId) {
+        return a.levelId < b.levelId;
+    }
+    return a.player < b.player;
+}
+
+void WriteVarInt(std::vector<std::byte>& buffer, int32_t value) noexcept {
+    auto zigzag = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    while(zigzag >= 0x80u) {
+        buffer.push_back(static_cast<std::byte>((zigzag & 0x7Fu) | 0x80u));
+        zigzag >>= 7;
+    }
+    buffer.push_back(static_cast<std::byte>(zigzag));
+}
+
+bool ReadVarInt(const std::vector<std::byte>& buffer, std::size_t& pos, int32_t& value) noexcept {
+    uint32_t zigzag = 0u;
+    for(int shift = 0; shift < 35; shift += 7) {
+        if(pos >= buffer.size()) {
+            return false;
+        }
+        const auto b = static_cast<uint32_t>(buffer[pos++]);
+        zigzag |= (b & 0x7Fu) << shift;
+        if(!(b & 0x80u)) {
+            value = static_cast<int32_t>(zigzag >> 1) ^ -static_cast<int32_t>(zigzag & 1u);
+            return true;
+        }
+    }
+    return false;
+}
+
+//Clamped well inside int32_t so a delta between two ticks cannot overflow either.
+int32_t Quantize(float value) noexcept {
+    constexpr auto limit = static_cast<double>(1 << 29);
+    const auto quantized = std::round(static_cast<double>(value) * GhostQuantization);
+    if(std::isnan(quantized)) {
+        return 0;
+    }
+    return static_cast<int32_t>(std::clamp(quantized, -limit, limit));
+}
+
+//Poses are quantized to 1/16th of a unit and degree, then stored as
+//zig-zag varint deltas from the previous tick. A lander moving smoothly
+//costs three or four bytes per tick instead of twelve.
+std::vector<std::byte> EncodeGhost(const std::vector<GhostFrame>& ghost) noexcept {
+    std::vector<std::byte> result{};
+    result.reserve(ghost.size() * 4u);
+    std::array<int32_t, 3> previous{};
+    for(const auto& frame : ghost) {
+        const auto current = std::array<int32_t, 3>{
+            Quantize(frame.position.x),
+            Quantize(frame.position.y),
+            Quantize(frame.orientationDegrees)
+        };
+        for(std::size_t i = 0u; i < current.size(); ++i) {
+            WriteVarInt(result, current[i] - previous[i]);
+        }
+        previous = current;
+    }
+    return result;
+}
+
+std::optional<std::vector<GhostFrame>> DecodeGhost(const std::vector<std::byte>& buffer, uint32_t tickCount) noexcept {
+    std::vector<GhostFrame> result{};
+    result.reserve(tickCount);
+    std::array<int32_t, 3> current{};
+    std::size_t pos = 0u;
+    for(uint32_t tick = 0u; tick < tickCount; ++tick) {
+        for(auto& value : current) {
+            int32_t delta{};
+            if(!ReadVarInt(buffer, pos, delta)) {
+                return {};
+            }
+            value += delta;
+        }
+        result.push_back(GhostFrame{Vector2{current[0] / GhostQuantization, current[1] / GhostQuantization}, current[2] / GhostQuantization});
+    }
+    return result;
+}
+
+bool WriteAt(void* file, uint64_t offset, const void* data, std::size_t size) noexcept {
+    LARGE_INTEGER position{};
+    position.QuadPart = static_cast<LONGLONG>(offset);
+    if(!::SetFilePointerEx(file, position, nullptr, FILE_BEGIN)) {
+        return false;
+    }
+    const auto* bytes = static_cast<const std::byte*>(data);
+    while(size) {
+        const auto chunk = static_cast<DWORD>((std::min)(size, std::size_t{0x40000000u}));
+        DWORD written{};
+        if(!::WriteFile(file, bytes, chunk, &written, nullptr) || written != chunk) {
+            return false;
+        }
+        bytes += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+bool TruncateAt(void* file, uint64_t offset) noexcept {
+    LARGE_INTEGER position{};
+    position.QuadPart = static_cast<LONGLONG>(offset);
+    return ::SetFilePointerEx(file, position, nullptr, FILE_BEGIN) && ::SetEndOfFile(file);
+}
+
+struct IndexSnapshot {
+    ScoreFormat::IndexHeader header{};
+    std::vector<uint64_t> segmentIds{};
+};
+
+uint32_t CalcIndexChecksum(ScoreFormat::IndexHeader header, std::span<const uint64_t> segmentIds) noexcept {
+    header.checksum = 0u;
+    const auto crc = CalcCrc32(0u, reinterpret_cast<const std::byte*>(&header), sizeof(header));
+    return CalcCrc32(crc, reinterpret_cast<const std::byte*>(segmentIds.data()), segmentIds.size_bytes());
+}
+
+std::optional<IndexSnapshot> ReadIndex(const std::filesystem::path& p) noexcept {
+    std::error_code ec{};
+    const auto file_size = std::filesystem::file_size(p, ec);
+    if(ec || file_size < sizeof(ScoreFormat::IndexHeader)) {
+        return {};
+    }
+    std::ifstream ifs{p, std::ios_base::binary};
+    IndexSnapshot snapshot{};
+    auto& header = snapshot.header;
+    if(!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != ScoreFormat::IndexMagic || header.version != ScoreFormat::Version) {
+        return {};
+    }
+    const auto id_bytes = file_size - sizeof(header);
+    if(id_bytes % sizeof(uint64_t) || header.segmentCount != id_bytes / sizeof(uint64_t)) {
+        return {};
+    }
+    snapshot.segmentIds.resize(header.segmentCount);
+    if(!ifs.read(reinterpret_cast<char*>(snapshot.segmentIds.data()), static_cast<std::streamsize>(snapshot.segmentIds.size() * sizeof(uint64_t)))) {
+        return {};
+    }
+    if(CalcIndexChecksum(header, snapshot.segmentIds) != header.checksum) {
+        return {};
+    }
+    return snapshot;
+}
+
+bool IsValidSegment(const MappedFile& segment) noexcept {
+    if(!segment.IsOpen() || segment.GetSize() < sizeof(ScoreFormat::SegmentHeader)) {
+        return false;
+    }
+    const auto& header = *segment.GetAs<ScoreFormat::SegmentHeader>();
+    if(header.magic != ScoreFormat::SegmentMagic || header.version != ScoreFormat::Version) {
+        return false;
+    }
+    const auto capacity = (segment.GetSize() - sizeof(header)) / sizeof(ScoreFormat::IndexEntry);
+    if(header.entryCount > capacity || header.bestCount > capacity - header.entryCount) {
+        return false;
+    }
+    return segment.GetSize() == sizeof(header) + (header.entryCount + header.bestCount) * sizeof(ScoreFormat::IndexEntry);
+}
+
+std::span<const ScoreFormat::IndexEntry> GetSegmentEntries(const MappedFile& segment) noexcept {
+    const auto& header = *segment.GetAs<ScoreFormat::SegmentHeader>();
+    return segment.GetArray<ScoreFormat::IndexEntry>(sizeof(header), header.entryCount);
+}
+
+std::span<const ScoreFormat::IndexEntry> GetSegmentBests(const MappedFile& segment) noexcept {
+    const auto& header = *segment.GetAs<ScoreFormat::SegmentHeader>();
+    return segment.GetArray<ScoreFormat::IndexEntry>(sizeof(header) + header.entryCount * sizeof(ScoreFormat::IndexEntry), header.bestCount);
+}
+
+std::span<const ScoreFormat::IndexEntry> FindLevelEntries(std::span<const ScoreFormat::IndexEntry> ranked, uint32_t levelId) noexcept {
+    const auto first = std::partition_point(std::begin(ranked), std::end(ranked), [levelId](const auto& entry) { return entry.levelId < levelId; });
+    const auto last = std::partition_point(first, std::end(ranked), [levelId](const auto& entry) { return entry.levelId == levelId; });
+    return std::span<const ScoreFormat::IndexEntry>{first, last};
+}
+
+//Ranked order puts each player's best first, so a stable sort by player keeps it at the front of its run.
+std::vector<ScoreFormat::IndexEntry> MergeBests(std::span<const ScoreFormat::IndexEntry> indexedBests, std::vector<ScoreFormat::IndexEntry> ranked) noexcept {
+    std::stable_sort(std::begin(ranked), std::end(ranked), IsPlayerBefore);
+    ranked.erase(std::unique(std::begin(ranked), std::end(ranked), [](const auto& a, const auto& b) { return !IsPlayerBefore(a, b) && !IsPlayerBefore(b, a); }), std::end(ranked));
+    std::vector<ScoreFormat::IndexEntry> bests{};
+    bests.reserve(indexedBests.size() + ranked.size());
+    auto old_iter = std::begin(indexedBests);
+    auto new_iter = std::begin(ranked);
+    while(old_iter != std::end(indexedBests) || new_iter != std::end(ranked)) {
+        if(new_iter == std::end(ranked) || (old_iter != std::end(indexedBests) && IsPlayerBefore(*old_iter, *new_iter))) {
+            bests.push_back(*old_iter++);
+        } else if(old_iter == std::end(indexedBests) || IsPlayerBefore(*new_iter, *old_iter)) {
+            bests.push_back(*new_iter++);
+        } else {
+            bests.push_back(IsRankedBefore(*new_iter, *old_iter) ? *new_iter : *old_iter);
+            ++old_iter;
+            ++new_iter;
+        }
+    }
+    return bests;
+}
+
+std::optional<uint64_t> ParseLogGeneration(const std::filesystem::path& p) noexcept {
+    if(p.extension() != ".log" || p.stem().stem() != "scores") {
+        return {};
+    }
+    const auto digits = p.stem().extension().string();
+    if(digits.size() < 2u) {
+        return {};
+    }
+    uint64_t generation{};
+    const auto [last, ec] = std::from_chars(digits.data() + 1, digits.data() + digits.size(), generation);
+    if(ec != std::errc{} || last != digits.data() + digits.size()) {
+        return {};
+    }
+    return generation;
+}
+
+void* OpenLogWriter(const std::filesystem::path& p, DWORD disposition) noexcept {
+    auto* file = ::CreateFileW(p.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+    return file == INVALID_HANDLE_VALUE ? nullptr : file;
+}
+
+} // namespace
+
+ScoreStore::ScoreStore(const std::filesystem::path& folder) noexcept
+: m_folder{folder}
+, m_indexPaths{folder / "scores.index.0", folder / "scores.index.1"}
+{
+    Open();
+}
+
+ScoreStore::~ScoreStore() noexcept {
+    {
+        std::scoped_lock lock(m_cs);
+        m_isRunning = false;
+    }
+    m_signal.notify_all();
+    if(m_worker.joinable()) {
+        m_worker.join();
+    }
+    if(m_logWriter) {
+        ::CloseHandle(m_logWriter);
+        m_logWriter = nullptr;
+    }
+}
+
+uint32_t ScoreStore::CalcLevelId(const std::string& levelName) noexcept {
+    uint32_t hash = 2166136261u;
+    for(const auto c : levelName) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void ScoreStore::Open() noexcept {
+    std::error_code ec{};
+    std::filesystem::create_directories(m_folder, ec);
+
+    OpenIndex();
+    if(!m_indexGeneration) {
+        m_logGeneration = FindNewestLogGeneration();
+    }
+
+    const auto log_path = CalcLogPath(m_logGeneration);
+    m_logWriter = OpenLogWriter(log_path, OPEN_ALWAYS);
+    if(!m_logWriter) {
+        g_theFileLogger->LogWarnLine("Score log " + log_path.string() + " could not be opened. Scores will not be saved.");
+        return;
+    }
+    m_logReader.open(log_path, std::ios_base::binary);
+    m_isOpen = true;
+    m_isRunning = true;
+    m_worker = std::thread(&ScoreStore::Worker, this);
+}
+
+void ScoreStore::OpenIndex() noexcept {
+    std::optional<IndexSnapshot> newest{};
+    std::optional<IndexSnapshot> fallback{};
+    for(std::size_t slot = 0u; slot < m_indexPaths.size(); ++slot) {
+        auto snapshot = ReadIndex(m_indexPaths[slot]);
+        if(!snapshot) {
+            continue;
+        }
+        for(const auto id : snapshot->segmentIds) {
+            m_nextSegmentId = (std::max)(m_nextSegmentId, id + 1u);
+        }
+        if(!newest || snapshot->header.generation > newest->header.generation) {
+            fallback = std::exchange(newest, std::move(snapshot));
+            m_indexSlot = slot;
+        } else {
+            fallback = std::move(snapshot);
+        }
+    }
+    if(!newest) {
+        return;
+    }
+    //The manifest still names the live log even if its segments are unusable; only the segments are given up on.
+    m_indexGeneration = newest->header.generation;
+    m_logGeneration = newest->header.logGeneration;
+    m_indexSegmentIds = newest->segmentIds;
+    if(fallback) {
+        m_fallbackSegmentIds = fallback->segmentIds;
+    }
+    SegmentList segments{};
+    for(const auto id : newest->segmentIds) {
+        auto file = MappedFile{CalcSegmentPath(id)};
+        if(!IsValidSegment(file)) {
+            g_theFileLogger->LogWarnLine("Score index segment " + CalcSegmentPath(id).string() + " is missing or damaged. Rebuilding the index from the log.");
+            return;
+        }
+        segments.push_back(std::make_shared<const IndexSegment>(IndexSegment{id, std::move(file)}));
+    }
+    m_segments = std::move(segments);
+    m_indexedLogSize = newest->header.logSize;
+    m_compactedLogSize = newest->header.compactedLogSize;
+}
+
+void ScoreStore::Recover() noexcept {
+    LARGE_INTEGER size{};
+    ::GetFileSizeEx(m_logWriter, &size);
+    const auto file_size = static_cast<uint64_t>(size.QuadPart);
+    if(!m_indexGeneration) {
+        RemoveStaleSegments();
+        RecoverLogTail(0u, file_size);
+        return;
+    }
+    RemoveStaleLogs();
+    if(file_size < m_indexedLogSize) {
+        //The index points past the end of the log, so its offsets would be reused by new runs. Start over from the log alone.
+        g_theFileLogger->LogWarnLine("Score log " + CalcLogPath(m_logGeneration).string() + " is shorter than its index. Rebuilding the index from the log.");
+        {
+            std::scoped_lock lock(m_cs);
+            m_segments.clear();
+        }
+        m_indexedLogSize = 0u;
+        m_compactedLogSize = 0u;
+    }
+    RemoveStaleSegments();
+    RecoverLogTail(m_indexedLogSize, file_size);
+}
+
+void ScoreStore::RecoverLogTail(uint64_t indexedLogSize, uint64_t fileSize) noexcept {
+    std::ifstream ifs{CalcLogPath(m_logGeneration), std::ios_base::binary};
+    auto offset = indexedLogSize;
+    ifs.seekg(static_cast<std::streamoff>(offset));
+    std::vector<ScoreFormat::IndexEntry> recovered{};
+    std::vector<std::byte> ghost{};
+    while(offset + sizeof(ScoreFormat::RunRecord) <= fileSize) {
+        ScoreFormat::RunRecord record{};
+        if(!ifs.read(reinterpret_cast<char*>(&record), sizeof(record)) || record.magic != ScoreFormat::LogMagic) {
+            break;
+        }
+        if(offset + sizeof(record) + record.ghostSize > fileSize) {
+            break;
+        }
+        ghost.resize(record.ghostSize);
+        if(!ifs.read(reinterpret_cast<char*>(ghost.data()), static_cast<std::streamsize>(ghost.size()))) {
+            break;
+        }
+        if(CalcRecordChecksum(record, ghost) != record.checksum) {
+            break;
+        }
+        recovered.push_back(ScoreFormat::IndexEntry{record.levelId, record.score, record.player, offset});
+        offset += sizeof(record) + record.ghostSize;
+    }
+    if(offset != fileSize) {
+        g_theFileLogger->LogWarnLine("Score log " + CalcLogPath(m_logGeneration).string() + " had an incomplete run at its end. Truncating.");
+        TruncateAt(m_logWriter, offset);
+    }
+    {
+        std::scoped_lock lock(m_cs);
+        m_pending.insert(std::end(m_pending), std::begin(recovered), std::end(recovered));
+    }
+    m_logSize = offset;
+}
+
+void ScoreStore::RemoveStaleLogs() const noexcept {
+    std::error_code ec{};
+    for(auto iter = std::filesystem::directory_iterator{m_folder, ec}; !ec && iter != std::filesystem::directory_iterator{}; iter.increment(ec)) {
+        if(const auto generation = ParseLogGeneration(iter->path()); generation && *generation != m_logGeneration) {
+            std::error_code remove_ec{};
+            std::filesystem::remove(iter->path(), remove_ec);
+        }
+    }
+}
+
+//Segments that neither manifest names were merged away or written by a pass that never committed.
+//The fallback manifest's segments are kept so it still works if the newer manifest is lost.
+void ScoreStore::RemoveStaleSegments() const noexcept {
+    const auto is_named = [this](const std::filesystem::path& p) {
+        const auto matches = [&](uint64_t id) { return CalcSegmentPath(id).filename() == p.filename(); };
+        return std::any_of(std::begin(m_indexSegmentIds), std::end(m_indexSegmentIds), matches)
+               || std::any_of(std::begin(m_fallbackSegmentIds), std::end(m_fallbackSegmentIds), matches);
+    };
+    std::error_code ec{};
+    for(auto iter = std::filesystem::directory_iterator{m_folder, ec}; !ec && iter != std::filesystem::directory_iterator{}; iter.increment(ec)) {
+        const auto& p = iter->path();
+        if(p.extension() != ".seg") {
+            continue;
+        }
+        if(!is_named(p)) {
+            std::error_code remove_ec{};
+            std::filesystem::remove(p, remove_ec);
+        }
+    }
+}
+
+void ScoreStore::Submit(RunResult run) noexcept {
+    if(!IsOpen()) {
+        return;
+    }
+    {
+        std::scoped_lock lock(m_cs);
+        m_queue.push_back(std::move(run));
+    }
+    m_signal.notify_one();
+}
+
+void ScoreStore::Worker() noexcept {
+    Recover();
+    ++m_changeCount;
+    for(;;) {
+        if(m_pending.size() >= IndexRebuildThreshold) {
+            FlushPending();
+            if(m_pending.empty() && m_logSize - m_compactedLogSize >= LogCompactionBytes) {
+                CompactLog();
+            }
+        }
+        std::deque<RunResult> runs{};
+        {
+            std::unique_lock lock(m_cs);
+            m_signal.wait(lock, [this]() { return !m_isRunning || !m_queue.empty(); });
+            if(m_queue.empty() && !m_isRunning) {
+                return;
+            }
+            runs.swap(m_queue);
+        }
+        for(const auto& run : runs) {
+            Append(run);
+        }
+        ++m_changeCount;
+    }
+}
+
+void ScoreStore::Append(const RunResult& run) noexcept {
+    const auto ghost = EncodeGhost(run.ghost);
+    ScoreFormat::RunRecord record{};
+    record.levelId = run.levelId;
+    record.score = run.score;
+    record.player = ToPlayerName(run.player);
+    record.touchdownSpeed = run.touchdownSpeed;
+    record.fuelLeft = run.fuelLeft;
+    record.tickCount = static_cast<uint32_t>(run.ghost.size());
+    record.ghostSize = static_cast<uint32_t>(ghost.size());
+    record.checksum = CalcRecordChecksum(record, ghost);
+
+    std::vector<std::byte> buffer(sizeof(record) + ghost.size());
+    std::memcpy(buffer.data(), &record, sizeof(record));
+    if(!ghost.empty()) {
+        std::memcpy(buffer.data() + sizeof(record), ghost.data(), ghost.size());
+    }
+    const auto offset = m_logSize.load();
+    if(!WriteAt(m_logWriter, offset, buffer.data(), buffer.size()) || !::FlushFileBuffers(m_logWriter)) {
+        g_theFileLogger->LogWarnLine("Score log " + CalcLogPath(m_logGeneration).string() + " could not be written. Run was not saved.");
+        TruncateAt(m_logWriter, offset);
+        return;
+    }
+    m_logSize = offset + buffer.size();
+    {
+        std::scoped_lock lock(m_cs);
+        m_pending.push_back(ScoreFormat::IndexEntry{record.levelId, record.score, record.player, offset});
+    }
+}
+
+void ScoreStore::FlushPending() noexcept {
+    //Only this thread changes m_segments or adds to m_pending, so both can be read here without the lock.
+    auto pending = m_pending;
+    const auto merged_count = pending.size();
+    const auto log_size = m_logSize.load();
+
+    std::sort(std::begin(pending), std::end(pending), IsRankedBefore);
+    const auto bests = MergeBests({}, pending);
+    auto segment = WriteSegment(pending, bests);
+    if(!segment) {
+        return;
+    }
+    auto segments = m_segments;
+    segments.push_back(std::move(segment));
+    while(segments.size() >= 2u) {
+        const auto& older = *segments[segments.size() - 2u];
+        const auto& newer = *segments.back();
+        if(GetSegmentEntries(newer.file).size() < GetSegmentEntries(older.file).size()) {
+            break;
+        }
+        auto merged = MergeSegments(older, newer);
+        if(!merged) {
+            break;
+        }
+        segments.pop_back();
+        segments.back() = std::move(merged);
+    }
+    if(!WriteIndex(segments, m_logGeneration, log_size, m_compactedLogSize)) {
+        return;
+    }
+    CommitSegments(std::move(segments), merged_count, log_size);
+}
+
+void ScoreStore::CommitSegments(SegmentList segments, std::size_t mergedPendingCount, uint64_t indexedLogSize) noexcept {
+    SegmentList retired{};
+    {
+        std::scoped_lock lock(m_cs);
+        retired = std::exchange(m_segments, std::move(segments));
+        m_pending.erase(std::begin(m_pending), std::begin(m_pending) + mergedPendingCount);
+        m_indexedLogSize = indexedLogSize;
+    }
+    //Unmap the retired segments before their files are removed.
+    retired.clear();
+    RemoveStaleSegments();
+}
+
+void ScoreStore::CompactLog() noexcept {
+    //Runs only right after FlushPending has folded every pending run into the segments, so they cover the whole log.
+    std::vector<ScoreFormat::IndexEntry> entries{};
+    std::vector<ScoreFormat::IndexEntry> bests{};
+    for(const auto& segment : m_segments) {
+        const auto segment_entries = GetSegmentEntries(segment->file);
+        const auto middle = static_cast<std::ptrdiff_t>(entries.size());
+        entries.insert(std::end(entries), std::begin(segment_entries), std::end(segment_entries));
+        std::inplace_merge(std::begin(entries), std::begin(entries) + middle, std::end(entries), IsRankedBefore);
+        const auto segment_bests = GetSegmentBests(segment->file);
+        bests = MergeBests(bests, std::vector<ScoreFormat::IndexEntry>(std::begin(segment_bests), std::end(segment_bests)));
+    }
+    std::vector<uint64_t> kept{};
+    for(auto first = std::begin(entries); first != std::end(entries);) {
+        const auto level_id = first->levelId;
+        const auto last = std::partition_point(first, std::end(entries), [level_id](const auto& entry) { return entry.levelId == level_id; });
+        const auto kept_count = (std::min)(GhostsKeptPerLevel, static_cast<std::size_t>(std::distance(first, last)));
+        std::transform(first, first + kept_count, std::back_inserter(kept), [](const auto& entry) { return entry.logOffset; });
+        first = last;
+    }
+    std::transform(std::begin(bests), std::end(bests), std::back_inserter(kept), [](const auto& entry) { return entry.logOffset; });
+    std::sort(std::begin(kept), std::end(kept));
+    kept.erase(std::unique(std::begin(kept), std::end(kept)), std::end(kept));
+
+    const auto old_path = CalcLogPath(m_logGeneration);
+    const auto new_generation = m_logGeneration + 1u;
+    const auto new_path = CalcLogPath(new_generation);
+    auto* new_log = OpenLogWriter(new_path, CREATE_ALWAYS);
+    if(!new_log) {
+        g_theFileLogger->LogWarnLine("Score log " + new_path.string() + " could not be created.");
+        return;
+    }
+    const auto abandon = [&]() {
+        ::CloseHandle(new_log);
+        std::error_code ec{};
+        std::filesystem::remove(new_path, ec);
+    };
+
+    //Every record survives so scores and offsets stay ordered; only ghosts nobody points at are dropped.
+    std::ifstream ifs{old_path, std::ios_base::binary};
+    std::vector<std::pair<uint64_t, uint64_t>> moved{};
+    std::vector<std::byte> buffer{};
+    std::vector<std::byte> ghost{};
+    const auto log_size = m_logSize.load();
+    uint64_t offset = 0u;
+    uint64_t written = 0u;
+    while(offset < log_size) {
+        ScoreFormat::RunRecord record{};
+        if(!ifs.read(reinterpret_cast<char*>(&record), sizeof(record)) || record.magic != ScoreFormat::LogMagic || offset + sizeof(record) + record.ghostSize > log_size) {
+            g_theFileLogger->LogWarnLine("Score log " + old_path.string() + " could not be compacted.");
+            abandon();
+            return;
+        }
+        const auto record_size = sizeof(record) + record.ghostSize;
+        ghost.resize(record.ghostSize);
+        if(!ifs.read(reinterpret_cast<char*>(ghost.data()), static_cast<std::streamsize>(ghost.size()))) {
+            g_theFileLogger->LogWarnLine("Score log " + old_path.string() + " could not be compacted.");
+            abandon();
+            return;
+        }
+        if(!std::binary_search(std::begin(kept), std::end(kept), offset)) {
+            ghost.clear();
+            record.tickCount = 0u;
+            record.ghostSize = 0u;
+            record.checksum = CalcRecordChecksum(record, ghost);
+        }
+        moved.emplace_back(offset, written + buffer.size());
+        offset += record_size;
+        const auto* record_bytes = reinterpret_cast<const std::byte*>(&record);
+        buffer.insert(std::end(buffer), record_bytes, record_bytes + sizeof(record));
+        buffer.insert(std::end(buffer), std::begin(ghost), std::end(ghost));
+        if(buffer.size() >= (1u << 20) || offset >= log_size) {
+            if(!WriteAt(new_log, written, buffer.data(), buffer.size())) {
+                g_theFileLogger->LogWarnLine("Score log " + new_path.string() + " could not be written.");
+                abandon();
+                return;
+            }
+            written += buffer.size();
+            buffer.clear();
+        }
+    }
+    if(!::FlushFileBuffers(new_log)) {
+        abandon();
+        return;
+    }
+
+    const auto remap = [&moved](ScoreFormat::IndexEntry entry) {
+        const auto found = std::lower_bound(std::begin(moved), std::end(moved), entry.logOffset, [](const auto& m, uint64_t value) { return m.first < value; });
+        entry.logOffset = found->second;
+        return entry;
+    };
+    std::transform(std::begin(entries), std::end(entries), std::begin(entries), remap);
+    std::transform(std::begin(bests), std::end(bests), std::begin(bests), remap);
+
+    //Every offset changed, so the whole index is rewritten as one segment. This is paid once per LogCompactionBytes of new log.
+    auto segment = WriteSegment(entries, bests);
+    if(!segment || !WriteIndex(SegmentList{segment}, new_generation, written, written)) {
+        abandon();
+        return;
+    }
+    ifs.close();
+    SegmentList retired{};
+    {
+        std::scoped_lock lock(m_cs, m_logReaderMutex);
+        retired = std::exchange(m_segments, SegmentList{std::move(segment)});
+        m_indexedLogSize = written;
+        m_logGeneration = new_generation;
+        m_logSize = written;
+        m_logReader.close();
+        m_logReader.open(new_path, std::ios_base::binary);
+    }
+    m_compactedLogSize = written;
+    ::CloseHandle(m_logWriter);
+    m_logWriter = new_log;
+    std::error_code ec{};
+    std::filesystem::remove(old_path, ec);
+    retired.clear();
+    RemoveStaleSegments();
+    ++m_changeCount;
+}
+
+std::shared_ptr<const ScoreStore::IndexSegment> ScoreStore::WriteSegment(std::span<const ScoreFormat::IndexEntry> entries, std::span<const ScoreFormat::IndexEntry> bests) noexcept {
+    ScoreFormat::SegmentHeader header{};
+    header.entryCount = entries.size();
+    header.bestCount = bests.size();
+
+    const auto id = m_nextSegmentId++;
+    const auto path = CalcSegmentPath(id);
+    auto* file = ::CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        g_theFileLogger->LogWarnLine("Score index segment " + path.string() + " could not be created.");
+        return {};
+    }
+    //One flush is enough: a segment only counts once a manifest written after it names it.
+    const auto entries_offset = uint64_t{sizeof(header)};
+    const auto bests_offset = entries_offset + entries.size_bytes();
+    const auto is_written = WriteAt(file, 0u, &header, sizeof(header))
+                            && WriteAt(file, entries_offset, entries.data(), entries.size_bytes())
+                            && WriteAt(file, bests_offset, bests.data(), bests.size_bytes())
+                            && ::FlushFileBuffers(file);
+    ::CloseHandle(file);
+    if(!is_written) {
+        g_theFileLogger->LogWarnLine("Score index segment " + path.string() + " could not be written.");
+        return {};
+    }
+    auto mapped = MappedFile{path};
+    if(!IsValidSegment(mapped)) {
+        g_theFileLogger->LogWarnLine("Score index segment " + path.string() + " could not be mapped.");
+        return {};
+    }
+    return std::make_shared<const IndexSegment>(IndexSegment{id, std::move(mapped)});
+}
+
+std::shared_ptr<const ScoreStore::IndexSegment> ScoreStore::MergeSegments(const IndexSegment& older, const IndexSegment& newer) noexcept {
+    const auto older_entries = GetSegmentEntries(older.file);
+    const auto newer_entries = GetSegmentEntries(newer.file);
+    std::vector<ScoreFormat::IndexEntry> entries{};
+    entries.reserve(older_entries.size() + newer_entries.size());
+    std::merge(std::begin(older_entries), std::end(older_entries), std::begin(newer_entries), std::end(newer_entries), std::back_inserter(entries), IsRankedBefore);
+    const auto newer_bests = GetSegmentBests(newer.file);
+    const auto bests = MergeBests(GetSegmentBests(older.file), std::vector<ScoreFormat::IndexEntry>(std::begin(newer_bests), std::end(newer_bests)));
+    return WriteSegment(entries, bests);
+}
+
+bool ScoreStore::WriteIndex(const SegmentList& segments, uint64_t logGeneration, uint64_t logSize, uint64_t compactedLogSize) noexcept {
+    std::vector<uint64_t> segment_ids{};
+    segment_ids.reserve(segments.size());
+    std::transform(std::begin(segments), std::end(segments), std::back_inserter(segment_ids), [](const auto& segment) { return segment->id; });
+
+    ScoreFormat::IndexHeader header{};
+    header.generation = m_indexGeneration + 1u;
+    header.logSize = logSize;
+    header.logGeneration = logGeneration;
+    header.compactedLogSize = compactedLogSize;
+    header.segmentCount = segment_ids.size();
+    header.checksum = CalcIndexChecksum(header, segment_ids);
+
+    std::vector<std::byte> buffer(sizeof(header) + segment_ids.size() * sizeof(uint64_t));
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    if(!segment_ids.empty()) {
+        std::memcpy(buffer.data() + sizeof(header), segment_ids.data(), segment_ids.size() * sizeof(uint64_t));
+    }
+
+    //Never overwrite the manifest in charge; a torn write to the other slot fails its checksum.
+    const auto next_slot = m_indexGeneration ? (m_indexSlot + 1u) % m_indexPaths.size() : 0u;
+    const auto& next_path = m_indexPaths[next_slot];
+    auto* file = ::CreateFileW(next_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        g_theFileLogger->LogWarnLine("Score index " + next_path.string() + " could not be created.");
+        return false;
+    }
+    const auto is_written = WriteAt(file, 0u, buffer.data(), buffer.size()) && ::FlushFileBuffers(file);
+    ::CloseHandle(file);
+    if(!is_written) {
+        g_theFileLogger->LogWarnLine("Score index " + next_path.string() + " could not be written.");
+        return false;
+    }
+    m_indexGeneration = header.generation;
+    m_indexSlot = next_slot;
+    m_fallbackSegmentIds = std::exchange(m_indexSegmentIds, std::move(segment_ids));
+    return true;
+}
+
+std::vector<ScoreEntry> ScoreStore::GetTopScores(uint32_t levelId, std::size_t k) const noexcept {
+    std::scoped_lock lock(m_cs);
+    std::vector<ScoreFormat::IndexEntry> top{};
+    for(const auto& segment : m_segments) {
+        const auto level_entries = FindLevelEntries(GetSegmentEntries(segment->file), levelId);
+        const auto count = (std::min)(k, level_entries.size());
+        top.insert(std::end(top), std::begin(level_entries), std::begin(level_entries) + count);
+    }
+    std::copy_if(std::begin(m_pending), std::end(m_pending), std::back_inserter(top), [levelId](const auto& entry) { return entry.levelId == levelId; });
+    const auto kept_count = (std::min)(k, top.size());
+    std::partial_sort(std::begin(top), std::begin(top) + kept_count, std::end(top), IsRankedBefore);
+    top.resize(kept_count);
+
+    std::vector<ScoreEntry> result{};
+    result.reserve(top.size());
+    std::transform(std::begin(top), std::end(top), std::back_inserter(result), [this](const auto& entry) { return ToScoreEntry(entry); });
+    return result;
+}
+
+std::optional<ScoreEntry> ScoreStore::GetPersonalBest(uint32_t levelId, const std::string& player) const noexcept {
+    const auto key = ScoreFormat::IndexEntry{levelId, 0u, ToPlayerName(player), 0u};
+    std::optional<ScoreFormat::IndexEntry> best{};
+    std::scoped_lock lock(m_cs);
+    for(const auto& segment : m_segments) {
+        const auto bests = GetSegmentBests(segment->file);
+        const auto found = std::lower_bound(std::begin(bests), std::end(bests), key, IsPlayerBefore);
+        if(found != std::end(bests) && !IsPlayerBefore(key, *found) && (!best || IsRankedBefore(*found, *best))) {
+            best = *found;
+        }
+    }
+    for(const auto& entry : m_pending) {
+        if(entry.levelId == levelId && entry.player == key.player && (!best || IsRankedBefore(entry, *best))) {
+            best = entry;
+        }
+    }
+    if(!best) {
+        return {};
+    }
+    return ToScoreEntry(*best);
+}
+
+std::optional<std::vector<GhostFrame>> ScoreStore::GetGhost(uint64_t runId) const noexcept {
+    const auto generation = runId >> RunIdOffsetBits;
+    const auto offset = runId & ((uint64_t{1} << RunIdOffsetBits) - 1u);
+    std::scoped_lock lock(m_logReaderMutex);
+    if(!m_logReader.is_open() || generation != m_logGeneration) {
+        return {};
+    }
+    const auto log_size = m_logSize.load();
+    if(offset > log_size || log_size - offset < sizeof(ScoreFormat::RunRecord)) {
+        return {};
+    }
+    m_logReader.clear();
+    m_logReader.seekg(static_cast<std::streamoff>(offset));
+    ScoreFormat::RunRecord record{};
+    if(!m_logReader.read(reinterpret_cast<char*>(&record), sizeof(record)) || record.magic != ScoreFormat::LogMagic) {
+        return {};
+    }
+    //Every tick costs at least one byte per channel, which also bounds the decode allocation.
+    const auto is_ghost_in_bounds = record.ghostSize <= log_size - offset - sizeof(record) && uint64_t{record.tickCount} * 3u <= record.ghostSize;
+    if(!is_ghost_in_bounds || record.tickCount == 0u) {
+        return {};
+    }
+    std::vector<std::byte> ghost(record.ghostSize);
+    if(!m_logReader.read(reinterpret_cast<char*>(ghost.data()), static_cast<std::streamsize>(ghost.size()))) {
+        return {};
+    }
+    if(CalcRecordChecksum(record, ghost) != record.checksum) {
+        return {};
+    }
+    return DecodeGhost(ghost, record.tickCount);
+}
+
+uint64_t ScoreStore::GetChangeCount() const noexcept {
+    return m_changeCount;
+}
+
+//Compaction swaps m_logWriter on the worker, so callers on other threads must not look at the handle.
+bool ScoreStore::IsOpen() const noexcept {
+    return m_isOpen;
+}
+
+std::filesystem::path ScoreStore::CalcLogPath(uint64_t logGeneration) const noexcept {
+    return m_folder / ("scores." + std::to_string(logGeneration) + ".log");
+}
+
+std::filesystem::path ScoreStore::CalcSegmentPath(uint64_t segmentId) const noexcept {
+    return m_folder / ("scores." + std::to_string(segmentId) + ".seg");
+}
+
+uint64_t ScoreStore::FindNewestLogGeneration() const noexcept {
+    uint64_t newest = 0u;
+    std::error_code ec{};
+    for(auto iter = std::filesystem::directory_iterator{m_folder, ec}; !ec && iter != std::filesystem::directory_iterator{}; iter.increment(ec)) {
+        if(const auto generation = ParseLogGeneration(iter->path()); generation) {
+            newest = (std::max)(newest, *generation);
+        }
+    }
+    return newest;
+}
+
+ScoreEntry ScoreStore::ToScoreEntry(const ScoreFormat::IndexEntry& entry) const noexcept {
+    return ScoreEntry{entry.levelId, entry.score, FromPlayerName(entry.player), (m_logGeneration << RunIdOffsetBits) | entry.logOffset};
+}
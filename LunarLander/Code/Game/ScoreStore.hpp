@@ -0,0 +1,206 @@
+#pragma once
+
+#include "Engine/Math/Vector2.hpp"
+
+#include "Game/MappedFile.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ScoreFormat {
+
+// Runs are appended to an append-only log as a RunRecord followed by the
+// run's compressed ghost. A record is only trusted if its checksum matches,
+// so a torn write at the tail is detected and truncated on the next open.
+// The index is a set of immutable, memory-mapped segments. Each segment
+// holds its runs sorted for top-K queries and one best entry per player for
+// personal best lookups. Every IndexRebuildThreshold runs the worker writes
+// the new runs as a segment. It then merges the two newest segments while the
+// newer one is at least as large as the older one, like carrying in a binary
+// counter. Each run is rewritten O(log n) times in total and at most
+// O(log n) segments are live.
+// A small manifest names the live segments and how much of the log they
+// cover. It alternates between two slots and carries a checksum, so a
+// crash mid-write leaves the previous manifest in charge.
+// The log itself is compacted into a new generation that keeps every
+// record but only the ghosts a leaderboard or personal best still points
+// at. The manifest names the log generation it describes, so the switch to
+// a new log happens when the new manifest lands.
+
+constexpr std::array<char, 4> LogMagic{'L', 'L', 'R', 'N'};
+constexpr std::array<char, 4> IndexMagic{'L', 'L', 'I', 'X'};
+constexpr std::array<char, 4> SegmentMagic{'L', 'L', 'S', 'G'};
+constexpr uint32_t Version = 1u;
+//Ghosts hold one frame per tick of this length whatever the frame rate,
+//so tickCount * GhostTickSeconds is the length of the recorded run.
+constexpr float GhostTickSeconds = 1.0f / 30.0f;
+
+using PlayerName = std::array<char, 16>;
+
+struct RunRecord {
+    std::array<char, 4> magic{LogMagic};
+    uint32_t checksum{0u};
+    uint32_t levelId{0u};
+    uint32_t score{0u};
+    PlayerName player{};
+    float touchdownSpeed{0.0f};
+    float fuelLeft{0.0f};
+    uint32_t tickCount{0u};
+    uint32_t ghostSize{0u};
+};
+
+//Followed by segmentCount segment ids, oldest first.
+struct IndexHeader {
+    std::array<char, 4> magic{IndexMagic};
+    uint32_t version{Version};
+    uint64_t generation{0u};
+    uint64_t logSize{0u};
+    uint64_t logGeneration{0u};
+    uint64_t compactedLogSize{0u};
+    uint64_t segmentCount{0u};
+    uint32_t checksum{0u};
+    uint32_t reserved{0u};
+};
+
+//Followed by entryCount entries in ranked order, then bestCount entries in player order.
+struct SegmentHeader {
+    std::array<char, 4> magic{SegmentMagic};
+    uint32_t version{Version};
+    uint64_t entryCount{0u};
+    uint64_t bestCount{0u};
+};
+
+struct IndexEntry {
+    uint32_t levelId{0u};
+    uint32_t score{0u};
+    PlayerName player{};
+    uint64_t logOffset{0u};
+};
+
+static_assert(sizeof(RunRecord) == 48u && std::is_trivially_copyable_v<RunRecord>);
+static_assert(sizeof(IndexHeader) == 56u && std::is_trivially_copyable_v<IndexHeader>);
+static_assert(sizeof(SegmentHeader) == 24u && std::is_trivially_copyable_v<SegmentHeader>);
+static_assert(sizeof(IndexEntry) == 32u && std::is_trivially_copyable_v<IndexEntry>);
+
+} // namespace ScoreFormat
+
+struct GhostFrame {
+    Vector2 position{};
+    float orientationDegrees{0.0f};
+};
+
+struct RunResult {
+    uint32_t levelId{0u};
+    uint32_t score{0u};
+    std::string player{};
+    float touchdownSpeed{0.0f};
+    float fuelLeft{0.0f};
+    std::vector<GhostFrame> ghost{};
+};
+
+struct ScoreEntry {
+    uint32_t levelId{0u};
+    uint32_t score{0u};
+    std::string player{};
+    uint64_t runId{0u};
+};
+
+class ScoreStore {
+public:
+    ScoreStore() noexcept = default;
+    explicit ScoreStore(const std::filesystem::path& folder) noexcept;
+    ScoreStore(const ScoreStore& other) = delete;
+    ScoreStore(ScoreStore&& other) = delete;
+    ScoreStore& operator=(const ScoreStore& other) = delete;
+    ScoreStore& operator=(ScoreStore&& other) = delete;
+    ~ScoreStore() noexcept;
+
+    static uint32_t CalcLevelId(const std::string& levelName) noexcept;
+
+    void Submit(RunResult run) noexcept;
+
+    [[nodiscard]] std::vector<ScoreEntry> GetTopScores(uint32_t levelId, std::size_t k) const noexcept;
+    [[nodiscard]] std::optional<ScoreEntry> GetPersonalBest(uint32_t levelId, const std::string& player) const noexcept;
+    [[nodiscard]] std::optional<std::vector<GhostFrame>> GetGhost(uint64_t runId) const noexcept;
+
+    //Bumped whenever query results may have changed: once the log has been
+    //recovered, after submitted runs are written and after compaction
+    //renumbers run ids. Queries made before the first bump may be incomplete.
+    uint64_t GetChangeCount() const noexcept;
+
+    bool IsOpen() const noexcept;
+
+protected:
+private:
+    struct IndexSegment {
+        uint64_t id{0u};
+        MappedFile file{};
+    };
+    using SegmentList = std::vector<std::shared_ptr<const IndexSegment>>;
+
+    //Pending runs are kept in memory, scanned by every query and replayed from
+    //the log on open. A larger threshold writes fewer, larger segments and
+    //merges less often, but makes queries and startup slower until they land.
+    static constexpr std::size_t IndexRebuildThreshold = 4096u;
+    static constexpr uint64_t LogCompactionBytes = 64u * 1024u * 1024u;
+    static constexpr std::size_t GhostsKeptPerLevel = 10u;
+    static constexpr int RunIdOffsetBits = 40;
+
+    void Open() noexcept;
+    void OpenIndex() noexcept;
+    void Recover() noexcept;
+    void RecoverLogTail(uint64_t indexedLogSize, uint64_t fileSize) noexcept;
+    void RemoveStaleLogs() const noexcept;
+    void RemoveStaleSegments() const noexcept;
+    void Worker() noexcept;
+    void Append(const RunResult& run) noexcept;
+    void FlushPending() noexcept;
+    void CompactLog() noexcept;
+    [[nodiscard]] std::shared_ptr<const IndexSegment> WriteSegment(std::span<const ScoreFormat::IndexEntry> entries, std::span<const ScoreFormat::IndexEntry> bests) noexcept;
+    [[nodiscard]] std::shared_ptr<const IndexSegment> MergeSegments(const IndexSegment& older, const IndexSegment& newer) noexcept;
+    [[nodiscard]] bool WriteIndex(const SegmentList& segments, uint64_t logGeneration, uint64_t logSize, uint64_t compactedLogSize) noexcept;
+    void CommitSegments(SegmentList segments, std::size_t mergedPendingCount, uint64_t indexedLogSize) noexcept;
+
+    std::filesystem::path CalcLogPath(uint64_t logGeneration) const noexcept;
+    std::filesystem::path CalcSegmentPath(uint64_t segmentId) const noexcept;
+    uint64_t FindNewestLogGeneration() const noexcept;
+    ScoreEntry ToScoreEntry(const ScoreFormat::IndexEntry& entry) const noexcept;
+
+    std::filesystem::path m_folder{};
+    std::array<std::filesystem::path, 2> m_indexPaths{};
+    std::size_t m_indexSlot{0u};
+    uint64_t m_indexGeneration{0u};
+    uint64_t m_indexedLogSize{0u};
+    uint64_t m_logGeneration{0u};
+    uint64_t m_compactedLogSize{0u};
+    uint64_t m_nextSegmentId{0u};
+    SegmentList m_segments{};
+    std::vector<uint64_t> m_indexSegmentIds{};
+    std::vector<uint64_t> m_fallbackSegmentIds{};
+    std::vector<ScoreFormat::IndexEntry> m_pending{};
+    std::deque<RunResult> m_queue{};
+    mutable std::ifstream m_logReader{};
+    mutable std::mutex m_logReaderMutex{};
+    mutable std::mutex m_cs{};
+    std::condition_variable m_signal{};
+    void* m_logWriter{nullptr};
+    std::atomic<uint64_t> m_logSize{0u};
+    std::atomic<uint64_t> m_changeCount{0u};
+    std::atomic<bool> m_isOpen{false};
+    std::thread m_worker{};
+    bool m_isRunning{false};
+};